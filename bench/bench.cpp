@@ -0,0 +1,190 @@
+// Measures the throughput of each compilation phase over a set of schema
+// files and prints the results as JSON, one object per file.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+#include "arena.hpp"
+#include "ast.hpp"
+#include "count_visitor.hpp"
+#include "flat_ast.hpp"
+#include "line_index.hpp"
+#include "output_sink.hpp"
+#include "parser.hpp"
+#include "schema.hpp"
+#include "source_file.hpp"
+#include "tostring_visitor.hpp"
+
+// Best-of-N wall time of one phase, in seconds.
+struct Phase {
+    const char *name;
+    double seconds;
+
+    Phase(const char *n): name(n), seconds(1e300) {}
+
+    void record(double s) {
+        if (s < seconds) seconds = s;
+    }
+};
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void printPhase(const Phase &phase, size_t bytes, size_t nodes, bool last) {
+    std::cout << "      \"" << phase.name << "\": {"
+              << "\"seconds\": " << phase.seconds
+              << ", \"mb_per_s\": " << bytes / phase.seconds / 1e6
+              << ", \"nodes_per_s\": " << nodes / phase.seconds
+              << "}" << (last ? "\n" : ",\n");
+}
+
+static bool run(const char *path, int iterations, bool first, int devNull) {
+    SourceFile src;
+    if (!src.open(path)) {
+        std::cerr << "failed to open file: " << path << std::endl;
+        return false;
+    }
+    size_t size = src.size();
+    // Scanning may touch the buffer, so every run starts from a fresh copy.
+    std::vector<char> work(size + SourceFile::PADDING);
+
+    Phase lex("lex"), parsing("parse"), visit("visit"), walk("walk"), schema("schema"), destroy("destroy");
+    // The same phases on a FlatAst, which parseFlat() builds directly.
+    Phase parsingFlat("parse_flat"), visitFlat("visit_flat"), walkFlat("walk_flat");
+    size_t tokens = 0, nodes = 0, arenaBytes = 0, flatBytes = 0;
+    FlatAst flat;
+    for (int it = 0; it < iterations; ++it) {
+        std::memcpy(work.data(), src.data(), size + SourceFile::PADDING);
+        double start = now();
+        tokens = countTokens(work.data(), size);
+        lex.record(now() - start);
+
+        std::memcpy(work.data(), src.data(), size + SourceFile::PADDING);
+        std::unique_ptr<Arena> arena(new Arena());
+        std::vector<Ast*> astLst;
+        start = now();
+        bool ok = parse(astLst, *arena, work.data(), size, std::cerr);
+        parsing.record(now() - start);
+        if (!ok) return false;
+
+        start = now();
+        {
+            FdSink sink(devNull);
+            ToStringVisitor visitor(sink);
+            for (size_t i = 0; i < astLst.size(); ++i) {
+                astLst[i]->accept(&visitor);
+            }
+        }
+        visit.record(now() - start);
+
+        CountVisitor counter;
+        start = now();
+        for (size_t i = 0; i < astLst.size(); ++i) {
+            counter.walk(astLst[i]);
+        }
+        walk.record(now() - start);
+
+        // A StaticVisitor pass: the struct declarations become a Schema.
+        // The generated sizes need not be valid, so its errors are dropped.
+        start = now();
+        {
+            Schema structs;
+            LineIndex lines(src.data(), size);
+            std::ostream nowhere(nullptr);
+            structs.build(astLst, lines, nowhere);
+        }
+        schema.record(now() - start);
+
+        if (it == 0) {
+            nodes = counter.total();
+            arenaBytes = arena->bytesUsed();
+        }
+
+        std::memcpy(work.data(), src.data(), size + SourceFile::PADDING);
+        start = now();
+        ok = parseFlat(flat, work.data(), size, std::cerr);
+        parsingFlat.record(now() - start);
+        if (!ok) return false;
+
+        start = now();
+        {
+            FdSink sink(devNull);
+            ToStringVisitor visitor(sink);
+            flat.accept(&visitor);
+        }
+        visitFlat.record(now() - start);
+
+        CountVisitor flatCounter;
+        start = now();
+        flatCounter.count(flat);
+        walkFlat.record(now() - start);
+        if (flatCounter.total() != nodes) {
+            std::cerr << path << ": the flat AST has " << flatCounter.total() << " nodes, the tree " << nodes << std::endl;
+            return false;
+        }
+        flatBytes = flat.nodes.size() * sizeof(FlatNode) + flat.lists.size() * sizeof(uint32_t);
+
+        start = now();
+        arena.reset();
+        destroy.record(now() - start);
+    }
+
+    std::cout << (first ? "" : ",\n")
+              << "    {\n"
+              << "      \"file\": \"" << path << "\",\n"
+              << "      \"bytes\": " << size << ",\n"
+              << "      \"tokens\": " << tokens << ",\n"
+              << "      \"nodes\": " << nodes << ",\n"
+              << "      \"arena_bytes\": " << arenaBytes << ",\n"
+              << "      \"flat_bytes\": " << flatBytes << ",\n";
+    printPhase(lex, size, nodes, false);
+    printPhase(parsing, size, nodes, false);
+    printPhase(visit, size, nodes, false);
+    printPhase(walk, size, nodes, false);
+    printPhase(schema, size, nodes, false);
+    printPhase(destroy, size, nodes, false);
+    printPhase(parsingFlat, size, nodes, false);
+    printPhase(visitFlat, size, nodes, false);
+    printPhase(walkFlat, size, nodes, true);
+    std::cout << "    }";
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int iterations = 5;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty() || iterations < 1) {
+        std::cerr << "usage: " << argv[0] << " [--iterations N] <file>..." << std::endl;
+        return 1;
+    }
+
+    // The printer's output is thrown away so that only printing is timed.
+    int devNull = open("/dev/null", O_WRONLY);
+    int status = 0;
+    std::cout << "{\n  \"version\": 1,\n  \"iterations\": " << iterations << ",\n  \"results\": [\n";
+    bool first = true;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!run(files[i], iterations, first, devNull)) {
+            status = 1;
+            continue;
+        }
+        first = false;
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    close(devNull);
+    return status;
+}
@@ -0,0 +1,104 @@
+// Parses each file into a tree and into a FlatAst, and checks that the flat
+// one, visited through FlatAst::accept(), prints the same, has the same
+// nodes at the same offsets, and that both parses wrote the same
+// diagnostics.
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "arena.hpp"
+#include "default_visitor.hpp"
+#include "flat_ast.hpp"
+#include "parser.hpp"
+#include "source_file.hpp"
+#include "tostring_visitor.hpp"
+#include "tree_walker.hpp"
+
+// Every node's kind and offset, in walk order.
+class Locations: public TreeWalker<Locations> {
+    public:
+    std::vector<uint64_t> nodes;
+
+    bool enter(Ast *ast) {
+        nodes.push_back(static_cast<uint64_t>(ast->kind) << 32 | ast->offset);
+        return true;
+    }
+};
+
+// Collects what a visit through FlatAst::accept() sees, before its nodes
+// are released.
+class FlatCollector: public DefaultVisitor {
+    public:
+    ToStringVisitor printer;
+    Locations locations;
+
+    void visit(Ast *ast) {
+        ast->accept(&printer);
+        locations.walk(ast);
+    }
+
+    void visitFunctionDeclaration(FunctionDeclaration *functionDeclaration) {
+        visit(functionDeclaration);
+    }
+
+    void visitStructDeclaration(StructDeclaration *structDeclaration) {
+        visit(structDeclaration);
+    }
+};
+
+static bool check(const char *path) {
+    SourceFile src;
+    if (!src.open(path)) {
+        std::cerr << "failed to open file: " << path << std::endl;
+        return false;
+    }
+    // Scanning may touch the buffer, so each parse gets its own copy.
+    std::vector<char> work(src.data(), src.data() + src.size() + SourceFile::PADDING);
+
+    Arena arena;
+    std::vector<Ast*> astLst;
+    std::ostringstream treeDiag;
+    bool treeOk = parse(astLst, arena, work.data(), src.size(), treeDiag);
+    ToStringVisitor printer;
+    Locations locations;
+    for (size_t i = 0; i < astLst.size(); ++i) {
+        astLst[i]->accept(&printer);
+        locations.walk(astLst[i]);
+    }
+
+    std::memcpy(work.data(), src.data(), work.size());
+    FlatAst flat;
+    std::ostringstream flatDiag;
+    bool flatOk = parseFlat(flat, work.data(), src.size(), flatDiag);
+    FlatCollector collector;
+    flat.accept(&collector);
+
+    if (treeOk != flatOk || treeDiag.str() != flatDiag.str()) {
+        std::cerr << path << ": diagnostics differ:\ntree:\n" << treeDiag.str() << "flat:\n" << flatDiag.str();
+        return false;
+    }
+    if (printer.getResult() != collector.printer.getResult()) {
+        std::cerr << path << ": the flat AST prints differently" << std::endl;
+        return false;
+    }
+    if (locations.nodes != collector.locations.nodes) {
+        std::cerr << path << ": the flat AST has different nodes or offsets" << std::endl;
+        return false;
+    }
+    std::cout << path << ": " << flat.nodes.size() << " nodes match the tree" << std::endl;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <file>..." << std::endl;
+        return 1;
+    }
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!check(argv[i])) status = 1;
+    }
+    return status;
+}
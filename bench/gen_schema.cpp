@@ -0,0 +1,299 @@
+// Writes a synthetic but syntactically valid schema to stdout, for
+// benchmarking ezpcc. The shape of the program is set on the command line.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Shape {
+    int structs;    // number of struct declarations
+    int fields;     // fields per struct
+    int depth;      // maximum expression depth
+    int body;       // statements per function body
+    int dims;       // maximum number of array dimensions of a field
+    int functions;  // number of function declarations
+    int chain;      // length of the chains in one extra function, 0 for none
+    unsigned seed;
+};
+
+static const char *const PRIMITIVES[] = {"bool", "byte", "short", "int", "long", "float", "double"};
+static const char *const BIN_OPS[] = {
+    "+", "-", "*", "/", "%", "&&", "||", "^", "&", "|", "<<", ">>", "<", ">", "<=", ">=", "==", "!="
+};
+static const char *const UNA_OPS[] = {"+", "-", "!", "~", "++", "--"};
+static const char *const ASG_OPS[] = {"=", "+=", "-=", "*=", "/=", "%=", "^=", "&=", "|=", "<<=", ">>="};
+
+template <typename T, size_t N>
+static size_t count(T (&)[N]) {
+    return N;
+}
+
+class Generator {
+    private:
+    Shape shape;
+    std::mt19937 rng;
+    std::ostream &out;
+    // Structs declared so far; only these may be used as types.
+    int declared;
+
+    int pick(int n) {
+        return std::uniform_int_distribution<int>(0, n - 1)(rng);
+    }
+
+    void name(const char *prefix, int i) {
+        out << prefix << i;
+    }
+
+    void type(bool allowDims) {
+        if (declared > 0 && pick(4) == 0) {
+            name("S", pick(declared));
+        } else {
+            out << PRIMITIVES[pick(count(PRIMITIVES))];
+        }
+        if (allowDims && shape.dims > 0) {
+            int dims = pick(shape.dims + 1);
+            for (int i = 0; i < dims; ++i) {
+                out << '[' << (1 + pick(16)) << ']';
+            }
+        }
+    }
+
+    void term(int depth) {
+        switch (depth <= 0 ? pick(3) : pick(9)) {
+            case 0:
+                name("v", pick(8));
+                break;
+            case 1:
+                out << pick(1000);
+                break;
+            case 2:
+                out << pick(100) << '.' << pick(100);
+                break;
+            case 3:
+                out << '(';
+                exp(depth - 1);
+                out << ')';
+                break;
+            case 4:
+                name("f", pick(8));
+                out << '(';
+                for (int i = 0, n = pick(3); i < n; ++i) {
+                    if (i > 0) out << ", ";
+                    exp(depth - 1);
+                }
+                out << ')';
+                break;
+            case 5:
+                name("v", pick(8));
+                out << '[';
+                exp(depth - 1);
+                out << ']';
+                break;
+            case 6:
+                name("v", pick(8));
+                out << '.';
+                name("m", pick(shape.fields > 0 ? shape.fields : 1));
+                break;
+            case 7:
+                out << UNA_OPS[pick(count(UNA_OPS))];
+                term(depth - 1);
+                break;
+            default:
+                out << '(';
+                type(false);
+                out << ") ";
+                term(depth - 1);
+        }
+    }
+
+    void exp(int depth) {
+        if (depth <= 0 || pick(3) == 0) {
+            term(depth);
+            return;
+        }
+        exp(depth - 1);
+        out << ' ' << BIN_OPS[pick(count(BIN_OPS))] << ' ';
+        term(depth - 1);
+    }
+
+    void indent(int level) {
+        for (int i = 0; i < level; ++i) {
+            out << "    ";
+        }
+    }
+
+    void block(int level, int stats) {
+        out << "{\n";
+        for (int i = 0; i < stats; ++i) {
+            stat(level + 1, stats / 2);
+        }
+        indent(level);
+        out << '}';
+    }
+
+    void stat(int level, int nested) {
+        indent(level);
+        switch (nested > 0 ? pick(7) : pick(4)) {
+            case 0:
+                type(true);
+                out << ' ';
+                name("v", pick(8));
+                out << " = ";
+                exp(shape.depth);
+                out << ";\n";
+                break;
+            case 1:
+                name("v", pick(8));
+                out << ' ' << ASG_OPS[pick(count(ASG_OPS))] << ' ';
+                exp(shape.depth);
+                out << ";\n";
+                break;
+            case 2:
+                exp(shape.depth);
+                out << ";\n";
+                break;
+            case 3:
+                out << "return ";
+                exp(shape.depth);
+                out << ";\n";
+                break;
+            case 4:
+                out << "while (";
+                exp(shape.depth);
+                out << ") ";
+                block(level, nested);
+                out << '\n';
+                break;
+            default:
+                out << "if (";
+                exp(shape.depth);
+                out << ") ";
+                block(level, nested);
+                while (pick(2) == 0) {
+                    out << " else if (";
+                    exp(shape.depth);
+                    out << ") ";
+                    block(level, nested);
+                }
+                if (pick(2) == 0) {
+                    out << " else ";
+                    block(level, nested);
+                }
+                out << '\n';
+        }
+    }
+
+    void structDecl(int i) {
+        out << "struct ";
+        name("S", i);
+        out << " {\n";
+        for (int f = 0; f < shape.fields; ++f) {
+            out << "    ";
+            type(true);
+            out << ' ';
+            name("m", f);
+            out << ";\n";
+        }
+        out << "}\n\n";
+        ++declared;
+    }
+
+    void functionDecl(int i) {
+        type(false);
+        out << ' ';
+        name("f", i);
+        out << '(';
+        for (int p = 0, n = pick(4); p < n; ++p) {
+            if (p > 0) out << ", ";
+            type(true);
+            out << ' ';
+            name("p", p);
+        }
+        out << ") ";
+        block(0, shape.body);
+        out << "\n\n";
+    }
+
+    // Nesting far beyond what the random shapes reach: an n-term `+` chain,
+    // an n-deep assignment chain and an n-rung else-if ladder.
+    void chainDecl(int n) {
+        out << "int chains(int v0) {\n    v0";
+        for (int i = 1; i < n; ++i) {
+            out << " = v" << i % 8;
+        }
+        out << ";\n    if (v0 == 0) {\n    }";
+        for (int i = 1; i < n; ++i) {
+            out << " else if (v0 == " << i << ") {\n    }";
+        }
+        out << "\n    return v0";
+        for (int i = 1; i < n; ++i) {
+            out << " + v" << i % 8;
+        }
+        out << ";\n}\n\n";
+    }
+
+    public:
+    Generator(const Shape &s, std::ostream &o): shape(s), rng(s.seed), out(o), declared(0) {}
+
+    void run() {
+        // Interleave functions between structs so that later functions can
+        // refer to every struct declared before them.
+        int total = shape.structs + shape.functions;
+        int s = 0, f = 0;
+        for (int i = 0; i < total; ++i) {
+            if (f >= shape.functions || (s < shape.structs && pick(total) < shape.structs)) {
+                structDecl(s++);
+            } else {
+                functionDecl(f++);
+            }
+        }
+        if (shape.chain > 0) chainDecl(shape.chain);
+    }
+};
+
+static void usage(const char *prog) {
+    std::cerr << "usage: " << prog
+              << " [--structs N] [--fields N] [--depth N] [--body N] [--dims N] [--functions N] [--chain N]"
+              << " [--seed N]"
+              << std::endl;
+}
+
+int main(int argc, char **argv) {
+    Shape shape = {100, 8, 3, 8, 2, 100, 0, 1};
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        int value = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--structs") == 0) {
+            shape.structs = value;
+        } else if (std::strcmp(argv[i], "--fields") == 0) {
+            shape.fields = value;
+        } else if (std::strcmp(argv[i], "--depth") == 0) {
+            shape.depth = value;
+        } else if (std::strcmp(argv[i], "--body") == 0) {
+            shape.body = value;
+        } else if (std::strcmp(argv[i], "--dims") == 0) {
+            shape.dims = value;
+        } else if (std::strcmp(argv[i], "--functions") == 0) {
+            shape.functions = value;
+        } else if (std::strcmp(argv[i], "--chain") == 0) {
+            shape.chain = value;
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            shape.seed = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        ++i;
+    }
+
+    std::ios::sync_with_stdio(false);
+    Generator gen(shape, std::cout);
+    gen.run();
+    return 0;
+}
@@ -0,0 +1,240 @@
+// Runs the hand-written scanner over the same files as a reference, and
+// reports the first token on which they disagree, in kind, value or
+// location. The reference is the flex scanner in flex builds, and in every
+// build a plain transcription of lexer.ll's rules.
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "arena.hpp"
+#include "parser.tab.hpp"
+#include "keywords.hpp"
+#include "number_literal.hpp"
+#include "simd_lexer.hpp"
+#include "source_file.hpp"
+#ifndef EZP_SIMD_LEXER
+#include "lexer.lex.hpp"
+#endif
+
+static bool sameValue(int token, const YYSTYPE &a, const YYSTYPE &b) {
+    switch (token) {
+        case ID:
+        case TYPE_NAME:
+            return a.sym == b.sym;
+        case TYPE:
+            return a.priType == b.priType;
+        case INT_CON:
+            return a.num.type == b.num.type && a.num.intVal == b.num.intVal;
+        case FLOAT_CON:
+            return a.num.type == b.num.type && std::memcmp(&a.num.floatVal, &b.num.floatVal, sizeof(double)) == 0;
+        default:
+            return true;
+    }
+}
+
+// The rules of lexer.ll applied the way flex applies them: at each position
+// the longest match wins, and the earlier rule on a tie. Written for
+// clarity rather than speed, it stands in for flex in builds without it.
+class RuleScanner {
+    ParseContext *ctx;
+    const char *begin, *cur, *end;
+
+    static bool isDigit(const char *p, const char *end) {
+        return p < end && *p >= '0' && *p <= '9';
+    }
+    static bool isIdent(const char *p, const char *end, bool digits) {
+        return p < end && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_' || (digits && *p >= '0' && *p <= '9'));
+    }
+    static const char *digits(const char *p, const char *end) {
+        while (isDigit(p, end)) ++p;
+        return p;
+    }
+
+    // Length of the literal operator rule that matches, and its token.
+    size_t op(int &token) const {
+        static const struct { const char *text; int token; } OPS[] = {
+            {"&&", AND}, {"||", OR}, {"++", INC}, {"--", DEC}, {"<<", LSH}, {">>", RSH},
+            {"<=", LE}, {">=", GE}, {"==", EQ}, {"!=", NEQ},
+            {"+=", ADD_ASG}, {"-=", SUB_ASG}, {"*=", MUL_ASG}, {"/=", DIV_ASG}, {"%=", MOD_ASG},
+            {"^=", XOR_ASG}, {"&=", AND_ASG}, {"|=", OR_ASG}, {"<<=", LSH_ASG}, {">>=", RSH_ASG}
+        };
+        size_t len = 0;
+        if (*cur != '\0' && std::strchr("+-*/%^&|~!<>()[]{}=.,;@", *cur) != nullptr) {
+            len = 1;
+            token = *cur;
+        }
+        for (const auto &o: OPS) {
+            size_t n = std::strlen(o.text);
+            if (n > len && static_cast<size_t>(end - cur) >= n && std::memcmp(cur, o.text, n) == 0) {
+                len = n;
+                token = o.token;
+            }
+        }
+        return len;
+    }
+    size_t ident() const {
+        if (!isIdent(cur, end, false)) return 0;
+        const char *p = cur + 1;
+        while (isIdent(p, end, true)) ++p;
+        return p - cur;
+    }
+    // ([0-9]+("."[0-9]*)?|"."[0-9]+){EXP}?[BSILFD]?, where an exponent
+    // without digits is not part of the match.
+    size_t number() const {
+        const char *p;
+        if (isDigit(cur, end)) {
+            p = digits(cur, end);
+            if (p < end && *p == '.') p = digits(p + 1, end);
+        } else if (*cur == '.' && isDigit(cur + 1, end)) {
+            p = digits(cur + 1, end);
+        } else {
+            return 0;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            const char *e = p + 1;
+            if (e < end && (*e == '-' || *e == '+')) ++e;
+            if (isDigit(e, end)) p = digits(e, end);
+        }
+        if (p < end && isNumberSuffix(*p)) ++p;
+        return p - cur;
+    }
+    size_t blank() const {
+        if (*cur == '\n') return 1;
+        const char *p = cur;
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        return p - cur;
+    }
+
+public:
+    RuleScanner(ParseContext *ctx, const char *text, size_t size)
+        : ctx(ctx), begin(text), cur(text), end(text + size) {}
+
+    int lex(YYSTYPE *lval, YYLTYPE *lloc) {
+        while (cur < end) {
+            enum { OP, IDENT, NUMBER, BLANK, OTHER } rule = OTHER;
+            int token = 0;
+            size_t len = op(token);
+            if (len > 0) rule = OP;
+            if (size_t n = ident(); n > len) {
+                len = n;
+                rule = IDENT;
+            }
+            if (size_t n = number(); n > len) {
+                len = n;
+                rule = NUMBER;
+            }
+            if (size_t n = blank(); n > len) {
+                len = n;
+                rule = BLANK;
+            }
+            if (rule == OTHER) len = 1;
+
+            const char *text = cur;
+            *lloc = text - begin;
+            cur += len;
+            switch (rule) {
+                case OP:
+                    return token;
+                case IDENT:
+                    if (const Keyword *kw = findKeyword(text, len)) {
+                        lval->priType = kw->type;
+                        return kw->token;
+                    }
+                    lval->sym = ctx->symbols.intern(std::string_view(text, len));
+                    return ctx->types.contains(lval->sym) ? TYPE_NAME : ID;
+                case NUMBER:
+                    if (!parseNumber(text, len, lval->num)) {
+                        ctx->error(*lloc, "invalid numeric literal");
+                        return YYerror;
+                    }
+                    return lval->num.type == TYP_FLOAT || lval->num.type == TYP_DOUBLE ? FLOAT_CON : INT_CON;
+                case OTHER:
+                    ctx->unexpected(*lloc, *text);
+                    return YYerror;
+                default:
+                    break;
+            }
+        }
+        return TOK_EOF;
+    }
+};
+
+// Compares next(), the reference, with the hand-written scanner token by
+// token, and then the diagnostics both wrote.
+template <typename Next>
+static bool compare(const char *path, const char *name, const SourceFile &src, ParseContext &ctx, Next next) {
+    std::ostringstream simdDiag;
+    ParseContext simdCtx(ctx.arena, simdDiag);
+    simdCtx.lines.reset(src.data(), src.size());
+    SimdScanner simd(&simdCtx);
+    simd.scanBuffer(src.data(), src.size());
+
+    YYSTYPE refVal, simdVal;
+    YYLTYPE refLoc = 0, simdLoc = 0;
+    size_t count = 0;
+    for (;;) {
+        int expected = next(&refVal, &refLoc);
+        int actual = simd.lex(&simdVal, &simdLoc);
+        if (expected != actual || !sameValue(expected, refVal, simdVal) || refLoc != simdLoc) {
+            std::cerr << path << ": token " << count << " differs: " << name << " " << expected << " at " << refLoc
+                      << ", simd " << actual << " at " << simdLoc << std::endl;
+            return false;
+        }
+        if (expected == TOK_EOF) break;
+        ++count;
+    }
+    std::ostringstream &refDiag = static_cast<std::ostringstream&>(ctx.diag);
+    if (refDiag.str() != simdDiag.str()) {
+        std::cerr << path << ": diagnostics differ:\n" << name << ":\n" << refDiag.str() << "simd:\n" << simdDiag.str();
+        return false;
+    }
+    std::cout << path << ": " << count << " tokens match " << name << std::endl;
+    return true;
+}
+
+static bool check(const char *path) {
+    SourceFile src;
+    if (!src.open(path)) {
+        std::cerr << "failed to open file: " << path << std::endl;
+        return false;
+    }
+
+    Arena arena;
+    std::ostringstream rulesDiag;
+    ParseContext rulesCtx(arena, rulesDiag);
+    rulesCtx.lines.reset(src.data(), src.size());
+    RuleScanner rules(&rulesCtx, src.data(), src.size());
+    bool ok = compare(path, "rules", src, rulesCtx, [&](YYSTYPE *lval, YYLTYPE *lloc) {
+        return rules.lex(lval, lloc);
+    });
+
+#ifndef EZP_SIMD_LEXER
+    // flex writes terminators into the buffer it scans.
+    std::vector<char> work(src.data(), src.data() + src.size() + SourceFile::PADDING);
+    std::ostringstream flexDiag;
+    ParseContext flexCtx(arena, flexDiag);
+    flexCtx.lines.reset(src.data(), src.size());
+    yyscan_t scanner;
+    yylex_init_extra(&flexCtx, &scanner);
+    yy_scan_buffer(work.data(), work.size(), scanner);
+    ok = compare(path, "flex", src, flexCtx, [&](YYSTYPE *lval, YYLTYPE *lloc) {
+        return yylex(lval, lloc, scanner);
+    }) && ok;
+    yylex_destroy(scanner);
+#endif
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <file>..." << std::endl;
+        return 1;
+    }
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!check(argv[i])) status = 1;
+    }
+    return status;
+}
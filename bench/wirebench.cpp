@@ -0,0 +1,223 @@
+// Compares the fixed and the compact wire encodings of bench/wire.ezp, in
+// bytes and nanoseconds per message, and the bulk varint decoder with a
+// value-at-a-time loop and a naive byte loop. Decoded data is checked
+// against what was encoded. Prints the results as JSON.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "wire.hpp"
+
+// Best-of-N wall time of one phase, in seconds.
+struct Phase {
+    const char *name;
+    double seconds;
+
+    Phase(const char *n): name(n), seconds(1e300) {}
+
+    void record(double s) {
+        if (s < seconds) seconds = s;
+    }
+};
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void printPhase(const Phase &phase, size_t count, const char *unit, bool last) {
+    std::cout << "    \"" << phase.name << "\": {"
+              << "\"seconds\": " << phase.seconds
+              << ", \"ns_per_" << unit << "\": " << phase.seconds / count * 1e9
+              << "}" << (last ? "\n" : ",\n");
+}
+
+// The textbook decoder the generated helpers have to beat: one byte per
+// iteration, no bounds or overflow checks beyond the buffer end.
+static const std::byte *naiveZigzag(const std::byte *in, const std::byte *end, int32_t &value) {
+    uint64_t u = 0;
+    for (unsigned shift = 0; in < end; shift += 7) {
+        uint8_t b = static_cast<uint8_t>(*in++);
+        u |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (b < 0x80) {
+            value = static_cast<int32_t>((u >> 1) ^ -(u & 1));
+            return in;
+        }
+    }
+    return nullptr;
+}
+
+// Tick has no operator==; the fixed encoding covers every field.
+static bool sameTicks(const std::vector<Tick> &a, const std::vector<Tick> &b) {
+    std::byte x[Tick::WIRE_SIZE], y[Tick::WIRE_SIZE];
+    for (size_t i = 0; i < a.size(); ++i) {
+        encode(a[i], x);
+        encode(b[i], y);
+        if (std::memcmp(x, y, sizeof(x)) != 0) return false;
+    }
+    return true;
+}
+
+// Values near what a feed carries: prices around a mid, small sizes and
+// counts, sequence numbers in the millions.
+static void fill(std::vector<Tick> &ticks, std::mt19937_64 &rng) {
+    auto r = [&](int64_t lo, int64_t hi) { return std::uniform_int_distribution<int64_t>(lo, hi)(rng); };
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        Tick &t = ticks[i];
+        t.seq = 5000000 + i;
+        t.stamp = 1700000000000000000 + i * 1000;
+        t.instrument = r(0, 5000);
+        t.side = r(0, 1);
+        int32_t mid = r(9000, 11000);
+        for (int k = 0; k < 10; ++k) {
+            t.bids[k].price = mid - k;
+            t.bids[k].size = r(1, 500);
+            t.bids[k].orders = r(1, 20);
+            t.asks[k].price = mid + k + 1;
+            t.asks[k].size = r(1, 500);
+            t.asks[k].orders = r(1, 20);
+        }
+        for (int k = 0; k < 32; ++k) t.trades[k] = r(-100, 100);
+        t.last = mid * 0.01;
+        t.halted = false;
+    }
+}
+
+int main(int argc, char **argv) {
+    int iterations = 5;
+    size_t messages = 100000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--messages") == 0 && i + 1 < argc) {
+            messages = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            iterations = 0;
+            break;
+        }
+    }
+    if (iterations < 1 || messages < 1) {
+        std::cerr << "usage: " << argv[0] << " [--iterations N] [--messages N]" << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 rng(1);
+    std::vector<Tick> ticks(messages), decoded(messages);
+    fill(ticks, rng);
+    std::vector<std::byte> fixedBuf(messages * Tick::WIRE_SIZE);
+    std::vector<std::byte> compactBuf(messages * Tick::MAX_COMPACT_SIZE);
+    size_t compactBytes = 0;
+
+    Phase fixedEncode("fixed_encode"), fixedDecode("fixed_decode");
+    Phase compactEncode("compact_encode"), compactDecode("compact_decode");
+    for (int it = 0; it < iterations; ++it) {
+        double start = now();
+        for (size_t i = 0; i < messages; ++i) {
+            encode(ticks[i], fixedBuf.data() + i * Tick::WIRE_SIZE);
+        }
+        fixedEncode.record(now() - start);
+
+        start = now();
+        for (size_t i = 0; i < messages; ++i) {
+            decode(decoded[i], fixedBuf.data() + i * Tick::WIRE_SIZE);
+        }
+        fixedDecode.record(now() - start);
+        if (!sameTicks(ticks, decoded)) {
+            std::cerr << "fixed decoding differs from the input" << std::endl;
+            return 1;
+        }
+        decoded.assign(messages, Tick());
+
+        start = now();
+        std::byte *out = compactBuf.data();
+        for (size_t i = 0; i < messages; ++i) {
+            out = encodeCompact(ticks[i], out);
+        }
+        compactEncode.record(now() - start);
+        compactBytes = out - compactBuf.data();
+
+        start = now();
+        const std::byte *in = compactBuf.data(), *end = out;
+        for (size_t i = 0; i < messages && in; ++i) {
+            in = decodeCompact(decoded[i], in, end);
+        }
+        compactDecode.record(now() - start);
+        if (in != end || !sameTicks(ticks, decoded)) {
+            std::cerr << "compact decoding failed" << std::endl;
+            return 1;
+        }
+        decoded.assign(messages, Tick());
+    }
+
+    // The same varints, decoded in one call, one at a time, and by the naive
+    // loop: values in the one-byte range, then values that mostly take two
+    // bytes.
+    const int32_t ranges[] = {63, 1000};
+    std::vector<Phase> bulk, scalar, naive;
+    std::vector<int32_t> values(messages * 16), back(values.size());
+    std::vector<std::byte> varints(values.size() * 5);
+    for (int32_t range: ranges) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = std::uniform_int_distribution<int32_t>(-range - 1, range)(rng);
+        }
+        const std::byte *varintEnd = ezp::putZigzags(varints.data(), values.data(), values.size());
+        bulk.push_back(Phase(range < 64 ? "bulk_decode_1_byte" : "bulk_decode_2_bytes"));
+        scalar.push_back(Phase(range < 64 ? "scalar_decode_1_byte" : "scalar_decode_2_bytes"));
+        naive.push_back(Phase(range < 64 ? "naive_decode_1_byte" : "naive_decode_2_bytes"));
+        for (int it = 0; it < iterations; ++it) {
+            double start = now();
+            const std::byte *in = ezp::getZigzags(varints.data(), varintEnd, back.data(), back.size());
+            bulk.back().record(now() - start);
+            if (in != varintEnd || back != values) {
+                std::cerr << bulk.back().name << " failed" << std::endl;
+                return 1;
+            }
+            back.assign(back.size(), 0);
+
+            start = now();
+            in = varints.data();
+            for (size_t i = 0; i < back.size() && in; ++i) {
+                in = ezp::getZigzag(in, varintEnd, back[i]);
+            }
+            scalar.back().record(now() - start);
+            if (in != varintEnd || back != values) {
+                std::cerr << scalar.back().name << " failed" << std::endl;
+                return 1;
+            }
+            back.assign(back.size(), 0);
+
+            start = now();
+            in = varints.data();
+            for (size_t i = 0; i < back.size() && in; ++i) {
+                in = naiveZigzag(in, varintEnd, back[i]);
+            }
+            naive.back().record(now() - start);
+            if (in != varintEnd || back != values) {
+                std::cerr << naive.back().name << " failed" << std::endl;
+                return 1;
+            }
+            back.assign(back.size(), 0);
+        }
+    }
+
+    std::cout << "{\n  \"version\": 2,\n  \"iterations\": " << iterations
+              << ",\n  \"messages\": " << messages << ",\n"
+              << "  \"bytes_per_message\": {\"fixed\": " << Tick::WIRE_SIZE
+              << ", \"compact\": " << double(compactBytes) / messages << "},\n"
+              << "  \"messages_per_run\": {\n";
+    printPhase(fixedEncode, messages, "message", false);
+    printPhase(fixedDecode, messages, "message", false);
+    printPhase(compactEncode, messages, "message", false);
+    printPhase(compactDecode, messages, "message", true);
+    std::cout << "  },\n  \"varints\": {\n";
+    for (size_t i = 0; i < bulk.size(); ++i) {
+        printPhase(bulk[i], values.size(), "value", false);
+        printPhase(scalar[i], values.size(), "value", false);
+        printPhase(naive[i], values.size(), "value", i + 1 == bulk.size());
+    }
+    std::cout << "  }\n}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+#ifndef __ARENA__
+#define __ARENA__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// A bump allocator owning every node of one compilation. Objects placed in an
+// arena never have their destructors run: the whole arena is released at once
+// when it is destroyed, so only trivially destructible state (or state that
+// itself lives in the arena) should be put there.
+class Arena {
+    private:
+    struct Block {
+        Block *next;
+        size_t size;
+    };
+
+    Block *head;
+    // Blocks given back by reset(), used before any new one is allocated.
+    Block *spare;
+    char *cur, *end;
+    size_t blockSize;
+    size_t used;
+
+    void *allocSlow(size_t size, size_t align);
+
+    static void freeBlocks(Block *block);
+
+    public:
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    Arena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena &operator=(const Arena&) = delete;
+
+    void *allocate(size_t size, size_t align) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(uintptr_t)(align - 1);
+        if (p > reinterpret_cast<uintptr_t>(end) || reinterpret_cast<uintptr_t>(end) - p < size) {
+            return allocSlow(size, align);
+        }
+        cur = reinterpret_cast<char*>(p + size);
+        used += size;
+        return reinterpret_cast<void*>(p);
+    }
+
+    // Copies len bytes of str into the arena and NUL-terminates the copy.
+    char *copy(const char *str, size_t len);
+
+    // Number of bytes handed out so far.
+    size_t bytesUsed() const;
+
+    // Drops everything allocated so far. Blocks of the default size are kept
+    // for reuse, so an arena that is refilled to the same size after a reset
+    // does not call malloc again; only oversized blocks are freed.
+    void reset();
+};
+
+// Allocator adapter so that standard containers can keep their storage in an
+// arena. Deallocation is a no-op; the memory goes away with the arena.
+template <typename T>
+class ArenaAllocator {
+    public:
+    typedef T value_type;
+
+    Arena *arena;
+
+    ArenaAllocator(Arena &a): arena(&a) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other): arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+};
+
+// Placement form used as `new (arena) T(...)`. sizeof(T) is always a multiple
+// of alignof(T), so aligning to the lowest set bit of the size is sufficient
+// and avoids padding small nodes up to max_align_t.
+inline void *operator new(size_t size, Arena &arena) {
+    size_t align = size & (~size + 1);
+    if (align > alignof(std::max_align_t) || align == 0) {
+        align = alignof(std::max_align_t);
+    }
+    return arena.allocate(size, align);
+}
+
+// Only called if a constructor throws; the memory is reclaimed with the arena.
+inline void operator delete(void*, Arena&) {}
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef __AST__
 #define __AST__
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
+#include "arena.hpp"
+#include "symbol_table.hpp"
+
 typedef enum {
     TYP_BOOL,
     TYP_BYTE,
@@ -60,25 +64,89 @@ typedef enum {
     ASG_RSH
 } AssignOperator;
 
+// Where a layout pass should put a struct field, from @hot or @cold.
+typedef enum {
+    HINT_NONE,
+    HINT_HOT,
+    HINT_COLD
+} FieldHint;
+
+// How a struct field goes on the wire in the compact encoding, from @fixed
+// or @varint; ENC_DEFAULT leaves it to the schema.
+typedef enum {
+    ENC_DEFAULT,
+    ENC_FIXED,
+    ENC_VARINT
+} FieldEncoding;
+
+// One value per concrete Ast subclass.
+typedef enum {
+    NODE_IDENTIFIER,
+    NODE_TYPE,
+    NODE_CONSTANT,
+    NODE_FUNCTION_CALL,
+    NODE_INDEX_OF,
+    NODE_ACCESS,
+    NODE_TYPE_CAST,
+    NODE_UNA_OP,
+    NODE_BIN_OP,
+    NODE_ASSIGN,
+    NODE_BREAK,
+    NODE_CONTINUE,
+    NODE_RETURN,
+    NODE_BLOCK,
+    NODE_EXP_STATEMENT,
+    NODE_DECLARATOR,
+    NODE_DECLARATION,
+    NODE_IF_STATEMENT,
+    NODE_WHILE_STATEMENT,
+    NODE_FORMAL_PARAMETER,
+    NODE_FUNCTION_HEADER,
+    NODE_FUNCTION_DECLARATION,
+    NODE_STRUCT_DECLARATION,
+    NUM_NODE_KINDS
+} NodeKind;
+
 class AstVisitor;
 
+// Child lists keep their storage in the same arena as the nodes they hold.
+template <typename T>
+using AstList = std::vector<T*, ArenaAllocator<T*>>;
+
+// Every node is allocated with `new (arena) Node(...)` and owned by that
+// Arena; nodes never own their children and are never deleted one by one.
 class Ast {
     public:
+    // Which subclass this is, for switch-based dispatch (see StaticVisitor).
+    const NodeKind kind;
+    // Byte offset in the source of the node's first token.
+    uint32_t offset;
+
     virtual ~Ast() = 0;
 
     virtual void accept(AstVisitor*) = 0;
+
+    protected:
+    Ast(NodeKind k): kind(k), offset(0) {}
 };
 
-class Expression: public Ast {};
+class Expression: public Ast {
+    protected:
+    Expression(NodeKind k): Ast(k) {}
+};
 
-class Statement: public Ast {};
+class Statement: public Ast {
+    protected:
+    Statement(NodeKind k): Ast(k) {}
+};
 
 class Identifier: public Expression {
     public:
-    std::string *name;
+    // Compare identifiers by sym; name is a view into the SymbolTable.
+    Symbol sym;
+    std::string_view name;
 
-    Identifier(std::string *n);
-    ~Identifier();
+    Identifier(Symbol s);
 
     void accept(AstVisitor *visitor);
 };
@@ -92,12 +160,11 @@ class Type: public Ast {
         Identifier *refType;
     };
     // A list of expressions holding the size of dimensions.
-    std::vector<Expression*> *dims;
+    AstList<Expression> *dims;
 
     Type(PrimitiveType t);
     Type(Identifier *r);
-    ~Type();
-    void setDims(std::vector<Expression*> *d);
+    void setDims(AstList<Expression> *d);
 
     void accept(AstVisitor *visitor);
 };
@@ -107,13 +174,13 @@ class Constant: public Expression {
     public:
     PrimitiveType type;
 
+    // Integral types and bool use intVal, float and double use floatVal.
     union {
-        int intVal;
-        float floatVal;
+        int64_t intVal;
+        double floatVal;
     };
-    Constant(int v);
-    Constant(float v);
-    ~Constant();
+    Constant(PrimitiveType t, int64_t v);
+    Constant(PrimitiveType t, double v);
 
     void accept(AstVisitor *visitor);
 };
@@ -121,10 +188,9 @@ class Constant: public Expression {
 class FunctionCall: public Expression {
     public:
     Expression *func;
-    std::vector<Expression*> *args;
+    AstList<Expression> *args;
 
-    FunctionCall(Expression *f, std::vector<Expression*> *a);
-    ~FunctionCall();
+    FunctionCall(Expression *f, AstList<Expression> *a);
 
     void accept(AstVisitor *visitor);
 };
@@ -134,7 +200,6 @@ class IndexOf: public Expression {
     Expression *var, *idx;
 
     IndexOf(Expression *v, Expression *i);
-    ~IndexOf();
 
     void accept(AstVisitor *visitor);
 };
@@ -144,7 +209,6 @@ class Access: public Expression {
     Expression *var, *field;
 
     Access(Expression *v, Expression *f);
-    ~Access();
 
     void accept(AstVisitor *visitor);
 };
@@ -155,7 +219,6 @@ class TypeCast: public Expression {
     Expression *expr;
 
     TypeCast(Type *t, Expression* e);
-    ~TypeCast();
 
     void accept(AstVisitor *visitor);
 };
@@ -166,7 +229,6 @@ class UnaOp: public Expression {
     Expression *expr;
 
     UnaOp(UnaryOperator o, Expression *e);
-    ~UnaOp();
 
     void accept(AstVisitor *visitor);
 };
@@ -177,7 +239,6 @@ class BinOp: public Expression {
     Expression *left, *right;
 
     BinOp(BinaryOperator o, Expression *l, Expression *r);
-    ~BinOp();
 
     void accept(AstVisitor *visitor);
 };
@@ -188,7 +249,6 @@ class Assign: public Expression {
     Expression *lval, *rval;
 
     Assign(AssignOperator o, Expression *lv, Expression *rv);
-    ~Assign();
 
     void accept(AstVisitor *visitor);
 };
@@ -196,11 +256,15 @@ class Assign: public Expression {
 // Statement
 class Break: public Statement {
     public:
+    Break();
+
     void accept(AstVisitor *visitor);
 };
 
 class Continue: public Statement {
     public:
+    Continue();
+
     void accept(AstVisitor *visitor);
 };
 
@@ -209,17 +273,15 @@ class Return: public Statement {
     Expression *var;
 
     Return(Expression *v);
-    ~Return();
 
     void accept(AstVisitor *visitor);
 };
 
 class Block: public Statement {
     public:
-    std::vector<Statement*> *stats;
+    AstList<Statement> *stats;
 
-    Block(std::vector<Statement*> *s);
-    ~Block();
+    Block(AstList<Statement> *s);
 
     void accept(AstVisitor *visitor);
 };
@@ -229,7 +291,6 @@ class ExpStatement: public Statement {
     Expression *expr;
 
     ExpStatement(Expression *e);
-    ~ExpStatement();
 
     void accept(AstVisitor *visitor);
 };
@@ -240,7 +301,6 @@ class Declarator: public Ast {
     Expression *exp;
 
     Declarator(Identifier *i, Expression *e);
-    ~Declarator();
 
     void accept(AstVisitor *visitor);
 };
@@ -248,10 +308,12 @@ class Declarator: public Ast {
 class Declaration: public Statement {
     public:
     Type *type;
-    std::vector<Declarator*> *varDecls;
+    AstList<Declarator> *varDecls;
+    // Only struct fields can be annotated.
+    FieldHint hint;
+    FieldEncoding encoding;
 
-    Declaration(Type *i, std::vector<Declarator*> *v);
-    ~Declaration();
+    Declaration(Type *i, AstList<Declarator> *v);
 
     void accept(AstVisitor *visitor);
 };
@@ -262,7 +324,6 @@ class IfStatement: public Statement {
     Statement *first, *second;
 
     IfStatement(Expression *c, Statement *f, Statement *s);
-    ~IfStatement();
 
     void accept(AstVisitor *visitor);
 };
@@ -273,7 +334,6 @@ class WhileStatement: public Statement {
     Statement *body;
 
     WhileStatement(Expression *c, Statement *b);
-    ~WhileStatement();
 
     void accept(AstVisitor *visitor);
 };
@@ -285,7 +345,6 @@ class FormalParameter: public Ast {
     Identifier *id;
 
     FormalParameter(Type *t, Identifier *i);
-    ~FormalParameter();
 
     void accept(AstVisitor *visitor);
 };
@@ -294,10 +353,9 @@ class FunctionHeader: public Ast {
     public:
     Type *type;
     Identifier *id;
-    std::vector<FormalParameter*> *paramLst;
+    AstList<FormalParameter> *paramLst;
 
-    FunctionHeader(Type *t, Identifier *i, std::vector<FormalParameter*> *p);
-    ~FunctionHeader();
+    FunctionHeader(Type *t, Identifier *i, AstList<FormalParameter> *p);
 
     void accept(AstVisitor *visitor);
 };
@@ -307,7 +365,6 @@ class FunctionDeclaration: public Ast {
     FunctionHeader *header;
     Block *body;
     FunctionDeclaration(FunctionHeader *h, Block *b);
-    ~FunctionDeclaration();
 
     void accept(AstVisitor *visitor);
 };
@@ -315,10 +372,9 @@ class FunctionDeclaration: public Ast {
 class StructDeclaration: public Ast {
     public:
     Identifier *id;
-    std::vector<Declaration*> *body;
+    AstList<Declaration> *body;
 
-    StructDeclaration(Identifier *i, std::vector<Declaration*> *b);
-    ~StructDeclaration();
+    StructDeclaration(Identifier *i, AstList<Declaration> *b);
 
     void accept(AstVisitor *visitor);
 };
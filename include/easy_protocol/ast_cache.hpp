@@ -0,0 +1,45 @@
+#ifndef __AST_CACHE__
+#define __AST_CACHE__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+#include "ast.hpp"
+
+// A compact binary image of a parsed file, so that unchanged sources can be
+// loaded without running the scanner or the parser. The warnings parsing
+// wrote are kept with it, so that they are reported again. A cache file
+// records the hash of the source it was built from and the format version;
+// it is only used when both still match.
+//
+// Layout, all integers little-endian as on the host:
+//   header   magic "EZPC", u32 version, u64 source hash,
+//            u32 symbol count, u32 top-level count
+//   symbols  per symbol: u32 length, bytes
+//   diag     u32 length, the warnings as written by the parser
+//   nodes    the top-level declarations in pre-order, each node a u8 tag,
+//            its u32 source offset and its fields, then its children; the
+//            fields include a u32 count for a child list and a u8 flag for
+//            an optional child, so that a node says how many children
+//            follow it.
+class AstCache {
+    public:
+    static const uint32_t VERSION = 8;
+
+    // Hash of a source's contents, as recorded in the cache.
+    static uint64_t hash(const char *data, size_t size);
+
+    // Writes astLst and the warnings parsing it produced to path, replacing
+    // any existing file atomically.
+    static bool write(const char *path, uint64_t sourceHash, const std::vector<Ast*> &astLst, const std::string &diag);
+
+    // Loads path into arena, and its warnings into diag, if it is a valid
+    // cache of the source with the given hash. Returns false, leaving astLst
+    // empty, otherwise.
+    static bool read(const char *path, uint64_t sourceHash, Arena &arena, std::vector<Ast*> &astLst, std::string &diag);
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef __CONSTANT_FOLDER__
+#define __CONSTANT_FOLDER__
+
+#include "arena.hpp"
+#include "ast.hpp"
+
+// Replaces an operator or cast whose operands are all constants by a
+// Constant holding its value, allocated in arena at the same offset.
+// Operands are expected to be folded already, so calling this on every
+// node as it is built, bottom-up, folds whole constant subexpressions
+// without recursing.
+//
+// Arithmetic follows C: bool, byte and short operands are promoted to int,
+// mixed operands to the wider type, and comparisons yield bool. Logical
+// operators take bools. Nodes that cannot be evaluated, such as ++ or %
+// on floating point, are returned unchanged. So is exp when its value is
+// undefined (signed overflow, division by zero, a shift by the width or
+// more, or a floating-point value cast to a type it does not fit); *error
+// is then set to a message for it, and is left alone otherwise.
+Expression *foldConstant(Expression *exp, Arena &arena, const char **error);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __COUNT_VISITOR__
+#define __COUNT_VISITOR__
+
+#include <cstddef>
+
+#include "flat_ast.hpp"
+#include "tree_walker.hpp"
+
+// Walks a whole tree and counts the nodes of every Ast subclass. Runs on
+// an explicit stack, so it copes with trees of any depth.
+class CountVisitor: public TreeWalker<CountVisitor> {
+    public:
+    // Class names, indexed by NodeKind like counts.
+    static const char *const NAMES[NUM_NODE_KINDS];
+
+    size_t counts[NUM_NODE_KINDS];
+
+    CountVisitor();
+
+    void clear();
+
+    size_t total() const;
+
+    // Adds the nodes of flat, in one scan over its node array.
+    void count(const FlatAst &flat);
+
+    bool enter(Ast *ast) {
+        ++counts[ast->kind];
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef __CPP_CODEGEN__
+#define __CPP_CODEGEN__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "output_sink.hpp"
+#include "schema.hpp"
+
+// Emits a self-contained C++17 header for a Schema. Every struct becomes a
+// plain C++ struct with a WIRE_SIZE constant and a pair of free functions
+//
+//   void encode(const S &v, std::byte *out) noexcept;
+//   void decode(S &v, const std::byte *in) noexcept;
+//
+// that write and read exactly WIRE_SIZE bytes of the packed layout described
+// in schema.hpp. Fields are copied with fixed-size memcpys at constant
+// offsets, so compilers lower them to plain loads and stores; the header
+// refuses to build on big-endian targets rather than byte-swap.
+//
+// Each struct also gets an SView, a read-only window on an encoded S that
+// reads single fields in place: an accessor per field, taking one index per
+// array dimension, that loads from its constant offset, and returns a view
+// of the element for nested structs. Its own members are prefixed with ezp
+// to stay clear of field names.
+//
+// If any field is a varint, every struct also gets a MAX_COMPACT_SIZE and
+//
+//   std::byte *encodeCompact(const S &v, std::byte *out) noexcept;
+//   const std::byte *decodeCompact(S &v, const std::byte *in, const std::byte *end) noexcept;
+//
+// for the compact encoding, which return where they stopped; decoding
+// fails with null on truncated or malformed input. The varint routines
+// they use are emitted once per program, in namespace ezp.
+class CppCodegen {
+    private:
+    OutputSink &out;
+    const Schema *schema;
+    // Whether the schema has varint fields, and so compact functions.
+    bool compact;
+
+    void emitStruct(const StructSchema &s);
+    void emitEncode(const StructSchema &s);
+    void emitDecode(const StructSchema &s);
+    void emitView(const StructSchema &s);
+    void emitEncodeCompact(const StructSchema &s);
+    void emitDecodeCompact(const StructSchema &s);
+    // Opens a loop over each of the first depth dimensions of field, and
+    // appends the subscripts of the current element to subscript.
+    void openLoops(const Field &field, size_t depth, std::string &subscript);
+    void closeLoops(size_t depth);
+    void number(uint64_t n);
+
+    public:
+    CppCodegen(OutputSink &o);
+
+    // The include guard used for a header generated from path: EZP_, the
+    // file name without directory or extension in upper case, and _HPP.
+    static std::string guardFor(std::string_view path);
+
+    void emit(const Schema &schema, std::string_view guard, std::string_view source);
+};
+
+#endif
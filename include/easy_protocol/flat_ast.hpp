@@ -0,0 +1,110 @@
+#ifndef __FLAT_AST__
+#define __FLAT_AST__
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "arena.hpp"
+#include "ast.hpp"
+
+// Index of a node in FlatAst::nodes, or of a child list in FlatAst::lists.
+typedef uint32_t NodeIndex;
+typedef uint32_t ListIndex;
+
+static const uint32_t NO_NODE = UINT32_MAX;
+
+// A node of the flat representation: its kind, one small operand, where it
+// starts in the source and up to three 32-bit fields. What the fields hold
+// depends on the kind:
+//
+//   Identifier           a = Symbol
+//   Type                 op = PrimitiveType, or NO_TYPE and a = Identifier;
+//                        b = dims list or NO_NODE
+//   Constant             op = PrimitiveType, b and c = low and high half of
+//                        the value's bits (intVal or floatVal)
+//   FunctionCall         a = func, b = args list
+//   IndexOf              a = var, b = idx
+//   Access               a = var, b = field
+//   TypeCast             a = Type, b = expr
+//   UnaOp                op = UnaryOperator, a = expr
+//   BinOp                op = BinaryOperator, a = left, b = right
+//   Assign               op = AssignOperator, a = lval, b = rval
+//   Break, Continue      -
+//   Return               a = var or NO_NODE
+//   Block                a = stats list
+//   ExpStatement         a = expr
+//   Declarator           a = Identifier, b = exp or NO_NODE
+//   Declaration          op = FieldHint | FieldEncoding << 4, a = Type,
+//                        b = declarators list
+//   IfStatement          a = condition, b = first, c = second or NO_NODE
+//   WhileStatement       a = condition, b = body
+//   FormalParameter      a = Type, b = Identifier
+//   FunctionHeader       a = Type, b = Identifier, c = parameters list
+//   FunctionDeclaration  a = FunctionHeader, b = Block
+//   StructDeclaration    a = Identifier, b = declarations list
+struct FlatNode {
+    uint8_t kind;
+    uint8_t op;
+    uint32_t offset;
+    uint32_t a, b, c;
+};
+
+// An AST stored in contiguous arrays, as built by parseFlat(). Nodes refer
+// to each other by 32-bit index; a child list is a run in `lists` made of
+// its length followed by the child indices. Children always come before
+// their parents, and each top-level declaration occupies the nodes from
+// just after the previous root up to its own root, so a forward scan over
+// `nodes` is a post-order traversal.
+class FlatAst {
+    public:
+    static const uint8_t NO_TYPE = 0xff;
+
+    std::vector<FlatNode> nodes;
+    std::vector<uint32_t> lists;
+    // The top-level declarations, in source order.
+    std::vector<NodeIndex> roots;
+
+    void clear();
+
+    const FlatNode &operator[](NodeIndex i) const {
+        return nodes[i];
+    }
+
+    NodeKind kind(NodeIndex i) const {
+        return static_cast<NodeKind>(nodes[i].kind);
+    }
+
+    uint32_t listSize(ListIndex l) const {
+        return lists[l];
+    }
+
+    // The children of list l, listSize(l) of them.
+    const NodeIndex *listBegin(ListIndex l) const {
+        return lists.data() + l + 1;
+    }
+
+    // The value bits of a Constant, as intVal or as floatVal.
+    int64_t intVal(NodeIndex i) const {
+        return static_cast<int64_t>(nodes[i].b | static_cast<uint64_t>(nodes[i].c) << 32);
+    }
+
+    double floatVal(NodeIndex i) const {
+        int64_t bits = intVal(i);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    // Rebuilds the top-level declaration roots[i] as pointer nodes in arena,
+    // in one forward scan over its nodes.
+    Ast *toTree(size_t i, Arena &arena) const;
+
+    // Runs an AstVisitor pass over every top-level declaration in source
+    // order. Each one is rebuilt by toTree() in a scratch arena that is
+    // reset after its visit, so memory stays bounded by the largest
+    // declaration.
+    void accept(AstVisitor *visitor) const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef __KEYWORDS__
+#define __KEYWORDS__
+
+#include <string_view>
+
+#include "parser.tab.hpp"
+
+// Keyword lookup shared by the scanners. Keywords are recognized by the
+// identifier rule through a perfect hash rather than by patterns of their
+// own, which keeps the flex DFA small.
+struct Keyword {
+    std::string_view name;
+    int token;
+    PrimitiveType type;
+};
+
+static constexpr Keyword KEYWORDS[] = {
+    {"bool", TYPE, TYP_BOOL},
+    {"byte", TYPE, TYP_BYTE},
+    {"short", TYPE, TYP_SHORT},
+    {"int", TYPE, TYP_INT},
+    {"long", TYPE, TYP_LONG},
+    {"float", TYPE, TYP_FLOAT},
+    {"double", TYPE, TYP_DOUBLE},
+    {"if", IF},
+    {"else", ELSE},
+    {"while", WHILE},
+    {"break", BREAK},
+    {"continue", CONTINUE},
+    {"return", RETURN},
+    {"struct", STRUCT}
+};
+
+static const unsigned KEYWORD_SLOTS = 32;
+
+// Collision-free over KEYWORDS; makeKeywordTable() fails to compile
+// otherwise.
+static constexpr unsigned keywordHash(const char *str, size_t len) {
+    return (len + static_cast<unsigned char>(str[0]) + static_cast<unsigned char>(str[len - 1]) * 10) & (KEYWORD_SLOTS - 1);
+}
+
+struct KeywordTable {
+    Keyword slots[KEYWORD_SLOTS];
+};
+
+static constexpr KeywordTable makeKeywordTable() {
+    KeywordTable table = {};
+    for (const Keyword &kw: KEYWORDS) {
+        Keyword &slot = table.slots[keywordHash(kw.name.data(), kw.name.size())];
+        if (!slot.name.empty()) throw "keyword hash collision";
+        slot = kw;
+    }
+    return table;
+}
+
+static constexpr KeywordTable KEYWORD_TABLE = makeKeywordTable();
+
+static inline const Keyword *findKeyword(const char *str, size_t len) {
+    const Keyword &kw = KEYWORD_TABLE.slots[keywordHash(str, len)];
+    return kw.name == std::string_view(str, len) ? &kw : nullptr;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __LAYOUT__
+#define __LAYOUT__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "schema.hpp"
+
+// Where the fields of a struct end up in memory under the usual C rules:
+// each field at a multiple of its alignment, the struct aligned like its
+// strictest field and its size rounded up to that. This is the layout of
+// the structs CppCodegen emits, not the packed wire layout.
+struct StructLayout {
+    // Field indices in memory order.
+    std::vector<size_t> order;
+    // Offset of each field, by field index.
+    std::vector<uint64_t> offsets;
+    uint64_t size, align;
+    // Bytes lost to padding between fields and at the end.
+    uint64_t padding;
+    // Number of cache lines holding at least one byte of a hot field, with
+    // the struct at the start of a line.
+    uint64_t hotLines;
+};
+
+class LayoutPlanner {
+    public:
+    static const uint64_t CACHE_LINE = 64;
+
+    // Lays out every struct of schema with its fields in declaration order,
+    // or, if optimize is set, in the order optimize() picks. Nested structs
+    // get the same treatment as the structs holding them.
+    static std::vector<StructLayout> plan(const Schema &schema, bool optimize);
+
+    // An order for the fields of s, given the layouts of the structs before
+    // it, that wastes as little padding as
+    // possible: hot fields first so they share the first cache line, then
+    // the rest, then cold fields, each group by decreasing alignment. With
+    // power-of-two alignments that leaves no holes inside a group. Fields
+    // that tie keep their declaration order.
+    static std::vector<size_t> optimize(const StructSchema &s, const std::vector<StructLayout> &nested);
+
+    // Lays out s with its fields in the given order; nested holds the
+    // layouts of the structs before it.
+    static StructLayout place(const StructSchema &s, const std::vector<size_t> &order, const std::vector<StructLayout> &nested);
+};
+
+#endif
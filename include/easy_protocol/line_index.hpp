@@ -0,0 +1,43 @@
+#ifndef __LINE_INDEX__
+#define __LINE_INDEX__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Source positions are kept as 32-bit byte offsets. A LineIndex turns them
+// into line and column numbers when a diagnostic needs them; the table of
+// line starts is only built on the first such query.
+class LineIndex {
+    private:
+    const char *text;
+    size_t size;
+    // Offset of text[0] and the number of the line it is on.
+    uint32_t base;
+    int firstLine;
+    // Offsets relative to text at which lines start; empty until needed,
+    // unless the source is appended piecewise.
+    std::vector<uint32_t> starts;
+
+    void build();
+
+    public:
+    struct Position {
+        int line;
+        int column;
+    };
+
+    LineIndex(const char *t = nullptr, size_t s = 0, uint32_t b = 0, int l = 1);
+
+    void reset(const char *t, size_t s, uint32_t b = 0, int l = 1);
+
+    // Adds the next n bytes of a source that is read a piece at a time and
+    // not kept, e.g. from a pipe. Their line starts are recorded right away.
+    // Start from an index reset to no text.
+    void append(const char *chunk, size_t n);
+
+    // Both numbered from 1. Offsets past the text land on its last line.
+    Position position(uint32_t offset);
+};
+
+#endif
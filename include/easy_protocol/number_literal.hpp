@@ -0,0 +1,31 @@
+#ifndef __NUMBER_LITERAL__
+#define __NUMBER_LITERAL__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ast.hpp"
+
+// The value of an INT_CON or FLOAT_CON token. The type comes from the
+// suffix: B, S, I or L for integers, F or D for floating point. Without
+// one, an integer is int, or long if it does not fit, and a number with a
+// point or an exponent is double, as in C.
+struct NumberLiteral {
+    PrimitiveType type;
+    union {
+        int64_t intVal;
+        double floatVal;
+    };
+};
+
+inline bool isNumberSuffix(char c) {
+    return c == 'B' || c == 'S' || c == 'I' || c == 'L' || c == 'F' || c == 'D';
+}
+
+// Converts the len bytes at text, which a scanner matched as digits with an
+// optional fraction, exponent and suffix. The text need not be terminated,
+// and the conversion ignores the locale. Returns false if the value does not
+// fit its type or an integer suffix follows a fraction or exponent.
+bool parseNumber(const char *text, size_t len, NumberLiteral &num);
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __OUTPUT_SINK__
+#define __OUTPUT_SINK__
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// A buffered byte stream. Writes are gathered in a fixed-size buffer that is
+// handed to flushChunk() whenever it fills up, so memory use does not depend
+// on how much is written.
+class OutputSink {
+    private:
+    char *buf, *cur, *end;
+
+    void overflow(const char *data, size_t len);
+
+    protected:
+    // Receives the buffered bytes; called by flush() and when the buffer fills.
+    virtual void flushChunk(const char *data, size_t len) = 0;
+
+    public:
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    OutputSink(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    // Subclasses must call flush() in their own destructor; it cannot be done
+    // here since flushChunk() is gone by then.
+    virtual ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink &operator=(const OutputSink&) = delete;
+
+    void write(const char *data, size_t len) {
+        if (static_cast<size_t>(end - cur) < len) {
+            overflow(data, len);
+            return;
+        }
+        std::memcpy(cur, data, len);
+        cur += len;
+    }
+
+    void write(std::string_view str) {
+        write(str.data(), str.size());
+    }
+
+    void write(const char *str) {
+        write(str, std::strlen(str));
+    }
+
+    void put(char c) {
+        if (cur == end) {
+            overflow(&c, 1);
+            return;
+        }
+        *cur++ = c;
+    }
+
+    // Writes n copies of c.
+    void fill(char c, size_t n);
+
+    void flush();
+};
+
+// Writes to a file descriptor, which is not closed.
+class FdSink: public OutputSink {
+    private:
+    int fd;
+    bool failed;
+
+    protected:
+    void flushChunk(const char *data, size_t len);
+
+    public:
+    FdSink(int fd, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    ~FdSink();
+
+    // Whether any write has failed so far.
+    bool error() const;
+};
+
+// Writes to a stdio stream, which is not closed.
+class FileSink: public OutputSink {
+    private:
+    FILE *file;
+
+    protected:
+    void flushChunk(const char *data, size_t len);
+
+    public:
+    FileSink(FILE *file, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    ~FileSink();
+};
+
+// Appends to a string owned by the sink.
+class StringSink: public OutputSink {
+    private:
+    std::string result;
+
+    protected:
+    void flushChunk(const char *data, size_t len);
+
+    public:
+    StringSink(size_t chunkSize = 256);
+    ~StringSink();
+
+    // Flushes and returns everything written so far.
+    const std::string &str();
+
+    void clear();
+};
+
+// Writes into a caller-owned buffer. Output beyond its capacity is dropped,
+// but still counted by size().
+class BufferSink: public OutputSink {
+    private:
+    char *dst;
+    size_t capacity, written;
+
+    protected:
+    void flushChunk(const char *data, size_t len);
+
+    public:
+    BufferSink(char *dst, size_t capacity, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    ~BufferSink();
+
+    // Total number of bytes written, including dropped ones, after a flush.
+    size_t size() const;
+
+    bool truncated() const;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef __PARSE_CONTEXT__
+#define __PARSE_CONTEXT__
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "arena.hpp"
+#include "ast.hpp"
+#include "constant_folder.hpp"
+#include "line_index.hpp"
+#include "number_literal.hpp"
+
+// What the scanners and both grammars, parser.yy and flat_parser.yy, share.
+
+typedef void* yyscan_t;
+class DeclarationSink;
+
+// Where a token or node starts, as a byte offset into the source. Lines
+// and columns are only worked out when a diagnostic needs them.
+struct SourceLoc {
+    uint32_t offset;
+
+    SourceLoc(): offset(0) {}
+    SourceLoc(uint32_t o): offset(o) {}
+    // Bison seeds the first location with {1, 1, 1, 1}, meant for
+    // line/column pairs; %initial-action replaces it.
+    SourceLoc(int, int, int, int): offset(0) {}
+
+    operator uint32_t() const {
+        return offset;
+    }
+};
+
+// The annotations in front of a struct field.
+struct FieldAnnotations {
+    FieldHint hint;
+    FieldEncoding encoding;
+};
+
+// State shared by the scanner (through yyextra) and the parser.
+struct ParseContext {
+    // Owns every node and child list built for this compilation.
+    Arena &arena;
+    // Names declared by `struct` so far; the scanner reports them as TYPE_NAME.
+    SymbolSet types;
+    SymbolCache symbols;
+    // Where syntax errors are reported.
+    std::ostream &diag;
+    // Byte offset of the next character the scanner will read. Token
+    // and node locations are plain offsets like this one.
+    uint32_t offset;
+    // Turns offsets back into lines and columns for diagnostics.
+    LineIndex lines;
+    // If set, receives each top-level declaration instead of the parse's
+    // list, and the arena is rewound after every one.
+    DeclarationSink *sink;
+
+    ParseContext(Arena &a, std::ostream &d): arena(a), diag(d), offset(0), sink(nullptr) {}
+
+    // Reports msg at offset to diag.
+    void error(uint32_t offset, const char *msg);
+
+    // Reports msg at offset to diag as a warning.
+    void warning(uint32_t offset, const char *msg);
+
+    // Reports a byte that starts no token. The scanners then return
+    // YYerror, which fails the parse.
+    void unexpected(uint32_t offset, char c);
+
+    // Applies foldConstant to a node just built from its operands. What
+    // it cannot evaluate only gets a warning, as in C: the expression is
+    // kept as written, and places that need a constant reject it later.
+    Expression *fold(Expression *exp);
+
+    // Hands over a top-level declaration once it has been reduced.
+    void declaration(std::vector<Ast*> &astLst, Ast *decl);
+};
+
+#endif
@@ -1,9 +1,104 @@
 #ifndef __PARSER__
 #define __PARSER__
 
+#include <cstdio>
+#include <iostream>
 #include <vector>
+#include "arena.hpp"
 #include "ast_visitor.hpp"
+#include "flat_ast.hpp"
+#include "source_file.hpp"
+#include "symbol_table.hpp"
 
-void parse(std::vector<Ast*> &astLst, FILE *file);
+// Receives top-level declarations one at a time, as soon as the parser has
+// reduced each of them.
+class DeclarationSink {
+    public:
+    virtual ~DeclarationSink() {}
+
+    // decl is a FunctionDeclaration or a StructDeclaration. Its nodes are
+    // only valid until this returns.
+    virtual void declaration(Ast *decl) = 0;
+};
+
+// Parses file into astLst and returns whether it was syntactically valid.
+// Every node is allocated in arena, which must outlive astLst; the nodes are
+// released together with the arena. Syntax errors are written to diag. The
+// file is read a block at a time, so it may be a pipe.
+bool parse(std::vector<Ast*> &astLst, Arena &arena, FILE *file, std::ostream &diag = std::cout);
+
+// Parses file a block at a time and passes each top-level declaration to
+// sink as soon as it is complete. Its nodes are freed right after, so memory
+// use is bounded by the largest declaration rather than by the file.
+// Declarations before a syntax error have already been delivered when this
+// returns false.
+bool parse(FILE *file, DeclarationSink &sink, std::ostream &diag = std::cout);
+
+// Scans buf in place without copying it. buf must hold size bytes of source
+// followed by SourceFile::PADDING NUL bytes and be writable: the scanner
+// temporarily stores terminators into it while it runs.
+bool parse(std::vector<Ast*> &astLst, Arena &arena, char *buf, size_t size, std::ostream &diag = std::cout);
+
+bool parse(std::vector<Ast*> &astLst, Arena &arena, SourceFile &src, std::ostream &diag = std::cout);
+
+// Parses one slice of a larger source, e.g. a chunk from splitSource().
+// buf starts at byte firstOffset of the source, on line firstLine; node
+// locations are offsets into the whole source. types holds the struct
+// names declared before the slice. buf is copied and never written to.
+bool parseChunk(
+    std::vector<Ast*> &astLst,
+    Arena &arena,
+    const char *buf,
+    size_t size,
+    uint32_t firstOffset,
+    int firstLine,
+    const std::vector<Symbol> &types,
+    std::ostream &diag = std::cout
+);
+
+// Parses a padded buffer, as accepted by parse(), into flat, whose previous
+// contents are dropped. The grammar and the diagnostics are the same as
+// parse()'s, but the nodes go straight into flat's arrays.
+bool parseFlat(FlatAst &flat, char *buf, size_t size, std::ostream &diag = std::cout);
+
+bool parseFlat(FlatAst &flat, SourceFile &src, std::ostream &diag = std::cout);
+
+struct ParseContext;
+
+// Parses many small sources one after another, e.g. for tools that embed
+// the compiler. The scanner, the arena, the copy of the input and the
+// symbol sets are set up once and kept warm between parses, instead of
+// being created and torn down by every call as the free functions above do.
+class ParserSession {
+    private:
+    Arena arena;
+    ParseContext *ctx;
+    void *scanner;
+    // The source being parsed, with the padding the scanner needs.
+    std::vector<char> text;
+
+    public:
+    ParserSession(std::ostream &diag = std::cout);
+    ~ParserSession();
+
+    ParserSession(const ParserSession&) = delete;
+    ParserSession &operator=(const ParserSession&) = delete;
+
+    // Parses a copy of the size bytes at buf into astLst. Each source starts
+    // with no struct names declared. The nodes stay valid until reset(), so
+    // several sources can be parsed before their trees are dropped.
+    bool parse(std::vector<Ast*> &astLst, const char *buf, size_t size);
+
+    // Drops every tree parsed so far. The memory is kept for the next ones.
+    void reset();
+
+    Arena &getArena() {
+        return arena;
+    }
+};
+
+// Runs only the scanner over a padded buffer, as accepted by parse(), and
+// returns the number of tokens. Used to time lexing on its own.
+size_t countTokens(char *buf, size_t size);
 
 #endif
@@ -0,0 +1,89 @@
+#ifndef __SCHEMA__
+#define __SCHEMA__
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "ast.hpp"
+#include "line_index.hpp"
+
+// The structs of a file, resolved for code generation. Each field is placed
+// in the packed wire layout: fields back to back in declaration order, with
+// no padding, integers and floats little-endian, arrays row-major and
+// nested structs inline.
+//
+// The compact encoding is the same except that some short, int and long
+// fields are written as zigzag LEB128 varints, so fields no longer sit at
+// fixed offsets.
+struct Field {
+    Symbol name;
+    // The element type: a primitive, or an earlier struct of the schema.
+    bool isPrimitive;
+    PrimitiveType type;
+    size_t structIndex;
+    // Array dimensions, outermost first; empty for a scalar.
+    std::vector<uint64_t> dims;
+    // Number of elements, 1 for a scalar.
+    uint64_t count;
+    // Byte offset in the enclosing struct and total byte size, on the wire.
+    uint64_t offset, size;
+    // Source offset of the declarator.
+    uint32_t location;
+    FieldHint hint;
+    // Written as varints in the compact encoding.
+    bool varint;
+    // Most bytes the field can take in the compact encoding.
+    uint64_t compactSize;
+};
+
+struct StructSchema {
+    Symbol name;
+    std::vector<Field> fields;
+    // Field indices in the order the generated in-memory struct declares
+    // them; declaration order unless a layout pass has changed it.
+    std::vector<size_t> order;
+    // Wire size of the whole struct, and the most its compact encoding
+    // can take.
+    uint64_t size, compactSize;
+    uint32_t location;
+};
+
+class Schema {
+    public:
+    // In declaration order, so a struct only refers to ones before it.
+    std::vector<StructSchema> structs;
+
+    // Limit on the size of a field or struct. It leaves enough headroom
+    // that in-memory layouts, which add padding, cannot overflow either.
+    static const uint64_t MAX_SIZE = 1ull << 48;
+
+    // Use varints for every short, int and long field not marked @fixed,
+    // rather than only for fields marked @varint. Set before build().
+    bool compact;
+
+    Schema(): compact(false) {}
+
+    // Wire size of one value of a primitive type.
+    static uint64_t primitiveSize(PrimitiveType type);
+
+    // Most bytes a varint of a value of type can take.
+    static uint64_t varintSize(PrimitiveType type);
+
+    // Whether any field is a varint, i.e. whether the compact encoding
+    // differs from the fixed one.
+    bool hasVarints() const;
+
+    // Wire size of one element of field.
+    uint64_t elementSize(const Field &field) const;
+
+    // Collects the struct declarations of astLst. Array dimensions must be
+    // positive integer constants, and names must be usable in the
+    // generated C++: no keywords, nothing the generated header declares
+    // itself, and no field name twice in one struct. Problems are reported
+    // to diag at their position, and make this return false.
+    bool build(const std::vector<Ast*> &astLst, LineIndex &lines, std::ostream &diag);
+};
+
+#endif
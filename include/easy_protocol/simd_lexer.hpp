@@ -0,0 +1,71 @@
+#ifndef __SIMD_LEXER__
+#define __SIMD_LEXER__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "parser.tab.hpp"
+
+// A hand-written scanner for the language of lexer.ll. It returns the same
+// tokens and fills yylval and yylloc exactly as the flex scanner does, but
+// skips blanks and classifies identifier and digit runs a vector at a time
+// (32 bytes with AVX2, 16 with SSE2, one byte otherwise).
+class SimdScanner {
+    private:
+    ParseContext *extra;
+    // Holds the input when it is not scanned in place.
+    std::vector<char> own;
+    const char *text, *cur, *end;
+    // Offset of text[0], taken from the context when scanning starts.
+    uint32_t base;
+    // The stream still being read, if any. Only whole lines of it are
+    // scanned, i.e. end is just past a newline, and the rest of own waits
+    // for the next block.
+    FILE *in;
+
+    void start(const char *buf, size_t size);
+
+    // Drops the scanned part of own and reads more of in. Returns whether
+    // there is anything left to scan.
+    bool refill();
+
+    void skipSpace(YYLTYPE *lloc);
+
+    public:
+    SimdScanner(ParseContext *e);
+
+    // Scans file, reading it a block at a time.
+    void setInput(FILE *file);
+
+    // Scans size bytes at buf, which must outlive the scanner. The bytes are
+    // never written to, and no padding is needed.
+    void scanBuffer(const char *buf, size_t size);
+
+    // Scans a copy of size bytes at buf.
+    void scanBytes(const char *buf, size_t size);
+
+    ParseContext *getExtra() const {
+        return extra;
+    }
+
+    int lex(YYSTYPE *lval, YYLTYPE *lloc);
+};
+
+#ifdef EZP_SIMD_LEXER
+// The part of flex's reentrant interface that the parser uses, implemented
+// on top of SimdScanner so that it can stand in for the flex scanner.
+int yylex_init_extra(ParseContext *extra, yyscan_t *scanner);
+int yylex_destroy(yyscan_t scanner);
+int yylex(YYSTYPE *lval, YYLTYPE *lloc, yyscan_t scanner);
+void yyset_in(FILE *file, yyscan_t scanner);
+// Both return the scanner rather than a flex buffer state.
+typedef void *YY_BUFFER_STATE;
+YY_BUFFER_STATE yy_scan_buffer(char *buf, size_t size, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_bytes(const char *buf, int len, yyscan_t scanner);
+// Does nothing: the scanner owns no buffer states.
+void yy_delete_buffer(YY_BUFFER_STATE state, yyscan_t scanner);
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef __SOURCE_FILE__
+#define __SOURCE_FILE__
+
+#include <cstddef>
+
+// The contents of a source file, ready to be scanned in place. Regular files
+// are memory-mapped privately, anything else (pipes, terminals) is read
+// into a heap buffer. Either way the text is followed by PADDING NUL bytes,
+// as required by the scanner, and the buffer is writable.
+class SourceFile {
+    private:
+    char *buf;
+    size_t len;
+    size_t mapped;
+
+    void release();
+
+    public:
+    static const size_t PADDING = 2;
+
+    SourceFile();
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile &operator=(const SourceFile&) = delete;
+
+    // Returns false (leaving the object empty) if path cannot be read.
+    bool open(const char *path);
+
+    // Takes the contents of an already open descriptor; fd is not closed.
+    bool open(int fd);
+
+    char *data() { return buf; }
+    const char *data() const { return buf; }
+    size_t size() const { return len; }
+};
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef __STATIC_VISITOR__
+#define __STATIC_VISITOR__
+
+#include "ast.hpp"
+
+// A visitor dispatched with a switch on Ast::kind instead of accept() and
+// virtual visitX() calls, so that whole passes can be inlined.
+//
+// Derive as `class MyPass: public StaticVisitor<MyPass>` and hide the
+// visitX() methods you need; call visit() on a node to run the pass. The
+// defaults walk the children in source order through Derived::visit(), so
+// a pass only handles the node kinds it cares about, and an override can
+// call StaticVisitor::visitX() to keep descending.
+template <typename Derived>
+class StaticVisitor {
+    protected:
+    Derived &self() {
+        return *static_cast<Derived*>(this);
+    }
+
+    void visitOpt(Ast *ast) {
+        if (ast != nullptr) self().visit(ast);
+    }
+
+    template <typename T>
+    void visitVec(AstList<T> *vec) {
+        if (vec == nullptr) return;
+        for (typename AstList<T>::iterator it = vec->begin(); it != vec->end(); ++it) {
+            self().visit(*it);
+        }
+    }
+
+    public:
+    void visit(Ast *ast) {
+        switch (ast->kind) {
+            case NODE_IDENTIFIER:
+                return self().visitIdentifier(static_cast<Identifier*>(ast));
+            case NODE_TYPE:
+                return self().visitType(static_cast<Type*>(ast));
+            case NODE_CONSTANT:
+                return self().visitConstant(static_cast<Constant*>(ast));
+            case NODE_FUNCTION_CALL:
+                return self().visitFunctionCall(static_cast<FunctionCall*>(ast));
+            case NODE_INDEX_OF:
+                return self().visitIndexOf(static_cast<IndexOf*>(ast));
+            case NODE_ACCESS:
+                return self().visitAccess(static_cast<Access*>(ast));
+            case NODE_TYPE_CAST:
+                return self().visitTypeCast(static_cast<TypeCast*>(ast));
+            case NODE_UNA_OP:
+                return self().visitUnaOp(static_cast<UnaOp*>(ast));
+            case NODE_BIN_OP:
+                return self().visitBinOp(static_cast<BinOp*>(ast));
+            case NODE_ASSIGN:
+                return self().visitAssign(static_cast<Assign*>(ast));
+            case NODE_BREAK:
+                return self().visitBreak(static_cast<Break*>(ast));
+            case NODE_CONTINUE:
+                return self().visitContinue(static_cast<Continue*>(ast));
+            case NODE_RETURN:
+                return self().visitReturn(static_cast<Return*>(ast));
+            case NODE_BLOCK:
+                return self().visitBlock(static_cast<Block*>(ast));
+            case NODE_EXP_STATEMENT:
+                return self().visitExpStatement(static_cast<ExpStatement*>(ast));
+            case NODE_DECLARATOR:
+                return self().visitDeclarator(static_cast<Declarator*>(ast));
+            case NODE_DECLARATION:
+                return self().visitDeclaration(static_cast<Declaration*>(ast));
+            case NODE_IF_STATEMENT:
+                return self().visitIfStatement(static_cast<IfStatement*>(ast));
+            case NODE_WHILE_STATEMENT:
+                return self().visitWhileStatement(static_cast<WhileStatement*>(ast));
+            case NODE_FORMAL_PARAMETER:
+                return self().visitFormalParameter(static_cast<FormalParameter*>(ast));
+            case NODE_FUNCTION_HEADER:
+                return self().visitFunctionHeader(static_cast<FunctionHeader*>(ast));
+            case NODE_FUNCTION_DECLARATION:
+                return self().visitFunctionDeclaration(static_cast<FunctionDeclaration*>(ast));
+            case NODE_STRUCT_DECLARATION:
+                return self().visitStructDeclaration(static_cast<StructDeclaration*>(ast));
+            default:
+                return;
+        }
+    }
+
+    void visitIdentifier(Identifier *id) {}
+
+    void visitType(Type *type) {
+        if (!type->isPrimitive) self().visit(type->refType);
+        visitVec(type->dims);
+    }
+
+    void visitConstant(Constant *constant) {}
+
+    void visitFunctionCall(FunctionCall *functionCall) {
+        self().visit(functionCall->func);
+        visitVec(functionCall->args);
+    }
+
+    void visitIndexOf(IndexOf *indexOf) {
+        self().visit(indexOf->var);
+        self().visit(indexOf->idx);
+    }
+
+    void visitAccess(Access *access) {
+        self().visit(access->var);
+        self().visit(access->field);
+    }
+
+    void visitTypeCast(TypeCast *typeCast) {
+        self().visit(typeCast->type);
+        self().visit(typeCast->expr);
+    }
+
+    void visitUnaOp(UnaOp *unaOp) {
+        self().visit(unaOp->expr);
+    }
+
+    void visitBinOp(BinOp *binOp) {
+        self().visit(binOp->left);
+        self().visit(binOp->right);
+    }
+
+    void visitAssign(Assign *assign) {
+        self().visit(assign->lval);
+        self().visit(assign->rval);
+    }
+
+    void visitBreak(Break *bk) {}
+
+    void visitContinue(Continue *ct) {}
+
+    void visitReturn(Return *r) {
+        visitOpt(r->var);
+    }
+
+    void visitBlock(Block *block) {
+        visitVec(block->stats);
+    }
+
+    void visitExpStatement(ExpStatement *expStatement) {
+        self().visit(expStatement->expr);
+    }
+
+    void visitDeclarator(Declarator *declarator) {
+        self().visit(declarator->id);
+        visitOpt(declarator->exp);
+    }
+
+    void visitDeclaration(Declaration *declaration) {
+        self().visit(declaration->type);
+        visitVec(declaration->varDecls);
+    }
+
+    void visitIfStatement(IfStatement *ifStatement) {
+        self().visit(ifStatement->condition);
+        self().visit(ifStatement->first);
+        visitOpt(ifStatement->second);
+    }
+
+    void visitWhileStatement(WhileStatement *whileStatement) {
+        self().visit(whileStatement->condition);
+        self().visit(whileStatement->body);
+    }
+
+    void visitFormalParameter(FormalParameter *formalParameter) {
+        self().visit(formalParameter->type);
+        self().visit(formalParameter->id);
+    }
+
+    void visitFunctionHeader(FunctionHeader *functionHeader) {
+        self().visit(functionHeader->type);
+        self().visit(functionHeader->id);
+        visitVec(functionHeader->paramLst);
+    }
+
+    void visitFunctionDeclaration(FunctionDeclaration *functionDeclaration) {
+        self().visit(functionDeclaration->header);
+        self().visit(functionDeclaration->body);
+    }
+
+    void visitStructDeclaration(StructDeclaration *structDeclaration) {
+        self().visit(structDeclaration->id);
+        visitVec(structDeclaration->body);
+    }
+};
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef __SYMBOL_TABLE__
+#define __SYMBOL_TABLE__
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+
+// Stable 32-bit handle of an interned name. Two identifiers have the same
+// spelling iff they have the same Symbol.
+typedef uint32_t Symbol;
+
+// Process-wide string interner. Names are copied once into storage that
+// lives as long as the table, so the views it hands out never dangle.
+class SymbolTable {
+    private:
+    static const unsigned PAGE_BITS = 12;
+    static const uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static const uint32_t MAX_PAGES = 1u << 16;
+
+    std::mutex mutex;
+    Arena storage;
+    std::unordered_map<std::string_view, Symbol> index;
+    // Names by symbol, in fixed-size pages so that lookups need no lock.
+    std::atomic<std::string_view*> pages[MAX_PAGES];
+    std::atomic<uint32_t> count;
+
+    public:
+    SymbolTable();
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable &operator=(const SymbolTable&) = delete;
+
+    static SymbolTable &global();
+
+    // Returns the symbol of str, adding it on first sight. Never allocates
+    // for a name that is already known.
+    Symbol intern(std::string_view str);
+
+    std::string_view name(Symbol sym) const {
+        return pages[sym >> PAGE_BITS].load(std::memory_order_acquire)[sym & (PAGE_SIZE - 1)];
+    }
+
+    uint32_t size() const;
+};
+
+// A private front for a SymbolTable, meant to be owned by one thread (e.g.
+// one parse). Names it has seen before are resolved without touching the
+// shared table or its lock.
+class SymbolCache {
+    private:
+    SymbolTable &table;
+    // Keys are views into the table's storage, so they stay valid.
+    std::unordered_map<std::string_view, Symbol> local;
+
+    public:
+    SymbolCache(SymbolTable &t = SymbolTable::global()): table(t) {}
+
+    Symbol intern(std::string_view str) {
+        std::unordered_map<std::string_view, Symbol>::iterator it = local.find(str);
+        if (it != local.end()) {
+            return it->second;
+        }
+        Symbol sym = table.intern(str);
+        local.emplace(table.name(sym), sym);
+        return sym;
+    }
+};
+
+// A set of symbols stored as a flat open-addressing table. Lookups never
+// allocate, and clear() keeps the table for reuse.
+class SymbolSet {
+    private:
+    static constexpr Symbol EMPTY = UINT32_MAX;
+    static const unsigned MIN_BITS = 4;
+
+    std::vector<Symbol> slots;
+    unsigned shift;
+    uint32_t count;
+
+    // Fibonacci hashing: the top bits of the product pick the slot.
+    size_t slot(Symbol sym) const {
+        return (sym * 0x9E3779B1u) >> shift;
+    }
+
+    void grow();
+
+    public:
+    SymbolSet(): slots(1u << MIN_BITS, EMPTY), shift(32 - MIN_BITS), count(0) {}
+
+    bool contains(Symbol sym) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = slot(sym); ; i = (i + 1) & mask) {
+            if (slots[i] == sym) return true;
+            if (slots[i] == EMPTY) return false;
+        }
+    }
+
+    // Returns whether sym was added.
+    bool insert(Symbol sym);
+
+    void clear();
+
+    uint32_t size() const {
+        return count;
+    }
+};
+
+#endif
@@ -1,36 +1,110 @@
 #ifndef __TOSTRING_VISITOR__
 #define __TOSTRING_VISITOR__
 
-#include "ast_visitor.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
 
+#include "ast_visitor.hpp"
+#include "output_sink.hpp"
+
+// Pretty-prints a tree. Output goes straight to a sink, so printing needs no
+// more memory than the sink's buffer; without a sink it is collected into a
+// string that getResult() returns.
+//
+// Printing recurses at most MAX_DEPTH levels. A subtree below that is
+// printed from a heap-allocated stack instead: there a visitX() method only
+// queues the pieces of its node, text and children, and the stack is drained
+// before returning. Trees of any depth can be printed, e.g. long generated
+// operator chains, while ordinary trees skip the queueing.
 class ToStringVisitor: public AstVisitor {
     private:
-    std::string result;
+    typedef enum {
+        ITEM_NODE,
+        ITEM_TEXT,
+        // Indentation at the current level.
+        ITEM_INDENT,
+        ITEM_ENTER_BLOCK,
+        ITEM_LEAVE_BLOCK
+    } ItemKind;
+
+    struct Item {
+        ItemKind kind;
+        Ast *node;
+        // Always a literal or a name owned by the SymbolTable.
+        std::string_view text;
+    };
+
+    static const int MAX_DEPTH = 256;
+    static const size_t INDENT_WIDTH = 4;
+
+    StringSink own;
+    OutputSink *out;
     int indentLevel;
-    static const std::string INDENT;
+    int depth;
+    // Set while a subtree is printed from pending.
+    bool queueing;
+    // What is still to be printed, the next piece last.
+    std::vector<Item> pending;
+
+    void indent(int level) {
+        out->fill(' ', level * INDENT_WIDTH);
+    }
+
+    // A node's pieces are produced in print order after begin(); end() puts
+    // any that were queued in stack order.
+    size_t begin() {
+        return pending.size();
+    }
+
+    void end(size_t mark);
+
+    void drain();
+
+    void run(ItemKind kind);
+
+    void node(Ast *ast);
+
+    void text(std::string_view s) {
+        if (queueing) {
+            if (!s.empty()) pending.push_back(Item{ITEM_TEXT, nullptr, s});
+        } else {
+            out->write(s);
+        }
+    }
+
+    void action(ItemKind kind) {
+        if (queueing) {
+            pending.push_back(Item{kind, nullptr, std::string_view()});
+        } else {
+            run(kind);
+        }
+    }
 
     template <typename T>
     void visitVec(
-            std::vector<T*> *vec,
-            std::string separator = " ",
-            std::string before = "",
-            std::string after = "") {
+            AstList<T> *vec,
+            const char *separator = " ",
+            const char *before = "",
+            const char *after = "") {
         if (vec == nullptr) return;
-        for (typename std::vector<T*>::iterator it = vec->begin(); it != vec->end(); ++it) {
-            result.append(before);
-            (*it)->accept(this);
-            result.append(after);
+        for (typename AstList<T>::iterator it = vec->begin(); it != vec->end(); ++it) {
+            text(before);
+            node(*it);
+            text(after);
             if (it != vec->end() - 1) {
-                result.append(separator);
+                text(separator);
             }
         }
     }
 
     public:
     ToStringVisitor();
+    ToStringVisitor(OutputSink &sink);
 
     void clear();
 
+    // Only meaningful when printing without a sink.
     std::string getResult();
 
     void visitIdentifier(Identifier *id);
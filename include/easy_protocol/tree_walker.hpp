@@ -0,0 +1,178 @@
+#ifndef __TREE_WALKER__
+#define __TREE_WALKER__
+
+#include <vector>
+
+#include "ast.hpp"
+
+// Depth-first traversal that keeps its own stack on the heap instead of
+// recursing, so trees of any depth can be walked, e.g. the long operator
+// chains produced by generated schemas.
+//
+// Derive as `class MyPass: public TreeWalker<MyPass>` and hide the hooks:
+// enter() runs before a node's children and returns whether to descend into
+// them; leave() runs after them, and only for nodes whose enter() returned
+// true. Children are visited in source order. The stack is kept between
+// walks, so reusing a walker does not allocate again.
+template <typename Derived>
+class TreeWalker {
+    private:
+    struct Frame {
+        Ast *node;
+        bool entered;
+    };
+
+    std::vector<Frame> stack;
+
+    void push(Ast *ast) {
+        if (ast != nullptr) stack.push_back(Frame{ast, false});
+    }
+
+    // Pushed back to front so that the first child is popped first.
+    template <typename T>
+    void pushVec(AstList<T> *vec) {
+        if (vec == nullptr) return;
+        for (typename AstList<T>::reverse_iterator it = vec->rbegin(); it != vec->rend(); ++it) {
+            push(*it);
+        }
+    }
+
+    void pushChildren(Ast *ast) {
+        switch (ast->kind) {
+            case NODE_TYPE: {
+                Type *type = static_cast<Type*>(ast);
+                pushVec(type->dims);
+                if (!type->isPrimitive) push(type->refType);
+                break;
+            }
+            case NODE_FUNCTION_CALL: {
+                FunctionCall *functionCall = static_cast<FunctionCall*>(ast);
+                pushVec(functionCall->args);
+                push(functionCall->func);
+                break;
+            }
+            case NODE_INDEX_OF: {
+                IndexOf *indexOf = static_cast<IndexOf*>(ast);
+                push(indexOf->idx);
+                push(indexOf->var);
+                break;
+            }
+            case NODE_ACCESS: {
+                Access *access = static_cast<Access*>(ast);
+                push(access->field);
+                push(access->var);
+                break;
+            }
+            case NODE_TYPE_CAST: {
+                TypeCast *typeCast = static_cast<TypeCast*>(ast);
+                push(typeCast->expr);
+                push(typeCast->type);
+                break;
+            }
+            case NODE_UNA_OP:
+                push(static_cast<UnaOp*>(ast)->expr);
+                break;
+            case NODE_BIN_OP: {
+                BinOp *binOp = static_cast<BinOp*>(ast);
+                push(binOp->right);
+                push(binOp->left);
+                break;
+            }
+            case NODE_ASSIGN: {
+                Assign *assign = static_cast<Assign*>(ast);
+                push(assign->rval);
+                push(assign->lval);
+                break;
+            }
+            case NODE_RETURN:
+                push(static_cast<Return*>(ast)->var);
+                break;
+            case NODE_BLOCK:
+                pushVec(static_cast<Block*>(ast)->stats);
+                break;
+            case NODE_EXP_STATEMENT:
+                push(static_cast<ExpStatement*>(ast)->expr);
+                break;
+            case NODE_DECLARATOR: {
+                Declarator *declarator = static_cast<Declarator*>(ast);
+                push(declarator->exp);
+                push(declarator->id);
+                break;
+            }
+            case NODE_DECLARATION: {
+                Declaration *declaration = static_cast<Declaration*>(ast);
+                pushVec(declaration->varDecls);
+                push(declaration->type);
+                break;
+            }
+            case NODE_IF_STATEMENT: {
+                IfStatement *ifStatement = static_cast<IfStatement*>(ast);
+                push(ifStatement->second);
+                push(ifStatement->first);
+                push(ifStatement->condition);
+                break;
+            }
+            case NODE_WHILE_STATEMENT: {
+                WhileStatement *whileStatement = static_cast<WhileStatement*>(ast);
+                push(whileStatement->body);
+                push(whileStatement->condition);
+                break;
+            }
+            case NODE_FORMAL_PARAMETER: {
+                FormalParameter *formalParameter = static_cast<FormalParameter*>(ast);
+                push(formalParameter->id);
+                push(formalParameter->type);
+                break;
+            }
+            case NODE_FUNCTION_HEADER: {
+                FunctionHeader *functionHeader = static_cast<FunctionHeader*>(ast);
+                pushVec(functionHeader->paramLst);
+                push(functionHeader->id);
+                push(functionHeader->type);
+                break;
+            }
+            case NODE_FUNCTION_DECLARATION: {
+                FunctionDeclaration *functionDeclaration = static_cast<FunctionDeclaration*>(ast);
+                push(functionDeclaration->body);
+                push(functionDeclaration->header);
+                break;
+            }
+            case NODE_STRUCT_DECLARATION: {
+                StructDeclaration *structDeclaration = static_cast<StructDeclaration*>(ast);
+                pushVec(structDeclaration->body);
+                push(structDeclaration->id);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    public:
+    bool enter(Ast *ast) {
+        return true;
+    }
+
+    void leave(Ast *ast) {}
+
+    void walk(Ast *root) {
+        Derived &self = *static_cast<Derived*>(this);
+        size_t base = stack.size();
+        push(root);
+        while (stack.size() > base) {
+            Frame &top = stack.back();
+            Ast *node = top.node;
+            if (top.entered) {
+                stack.pop_back();
+                self.leave(node);
+            } else if (self.enter(node)) {
+                top.entered = true;
+                pushChildren(node);
+            } else {
+                stack.pop_back();
+            }
+        }
+    }
+};
+
+#endif